@@ -23,6 +23,20 @@
 // ADDED 9.25: the reverse function in the code
 int dsp_reverse(float *iAudioPtr, int iNumSamples, float *oAudioPtr);
 
+//==============================================================================
+// View of one channel of a juce::AudioBuffer in the pointer + length form the dsp.h functions take. The view
+// does not own or copy anything; it is valid until the buffer is resized or destroyed.
+struct DspChannelView
+{
+    float*  samples;
+    int     numSamples;
+};
+
+static inline DspChannelView dspChannelView (juce::AudioBuffer<float>& buffer, int channel)
+{
+    return { buffer.getWritePointer (channel), buffer.getNumSamples() };
+}
+
 
 //==============================================================================
 class MainContentComponent   : public juce::AudioAppComponent,
@@ -65,6 +79,24 @@ public:
         analyzeButton.setColour (juce::TextButton::buttonColourId, juce::Colours::blue);
         analyzeButton.setEnabled (true);
         
+        addAndMakeVisible (&liveButton);
+        liveButton.setButtonText ("Live");
+        liveButton.onClick = [this] { liveButtonClicked(); };
+        liveButton.setColour (juce::TextButton::buttonColourId, juce::Colours::darkorange);
+        
+        // live tremolo controls, sent to the audio thread through the host's parameter queue
+        addAndMakeVisible (&rateSlider);
+        rateSlider.setRange (0.5, 20.0, 0.1);
+        rateSlider.setValue (4.0, juce::dontSendNotification);
+        rateSlider.setTextValueSuffix (" Hz");
+        rateSlider.onValueChange = [this] { sendLiveParam (DSP_PARAM_TREMOLO_RATE, (float) rateSlider.getValue()); };
+        
+        addAndMakeVisible (&depthSlider);
+        depthSlider.setRange (0.0, 100.0, 1.0);
+        depthSlider.setValue (60.0, juce::dontSendNotification);
+        depthSlider.setTextValueSuffix (" %");
+        depthSlider.onValueChange = [this] { sendLiveParam (DSP_PARAM_TREMOLO_DEPTH, (float) depthSlider.getValue()); };
+        
         setSize (1200, 900);
         
         formatManager.registerBasicFormats();
@@ -83,30 +115,48 @@ public:
         _analysisRect.setY(45);
         
         _outputFile = juce::File(outputFilePath);
+        
+        dsp_bufferPoolCreate(&_bufferPool);
     }
 
     //....................................................................................................... ~MainContentComponent
     ~MainContentComponent() override
     {
+        stopLive();
         shutdownAudio();
         
-        if(_inAudioPtr != NULL)
-            free(_inAudioPtr);
-        
-        if(_outAudioPtr != NULL)
-            free(_outAudioPtr);
+        dsp_bufferRelease(_bufferPool, _inAudioStorage);
+        dsp_bufferPoolDestroy(_bufferPool);
     }
         
     //....................................................................................................... prepareToPlay
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override
     {
         transportSource.prepareToPlay (samplesPerBlockExpected, sampleRate);
+        
+        // everything the live path needs is allocated here, never in getNextAudioBlock; the ring holds a few
+        // device blocks so the feeder thread has slack
+        stopLive();
+        dsp_realtimeHostDestroy (_liveHost);
+        _liveHost = nullptr;
+        _deviceRate = (int) sampleRate;
+        dsp_realtimeHostCreate (&_liveHost, _deviceRate, samplesPerBlockExpected,
+                                std::max (8 * samplesPerBlockExpected, 8192));
     }
 
     //....................................................................................................... getNextAudioBlock
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override
     {
-        if (readerSource.get() == nullptr)
+        if (_live.load() && _liveHost != nullptr)
+        {
+            // live audition: the feeder thread keeps the host's ring filled, the effects run here on the first
+            // channel with no locks, allocations or file access, and the result goes to every channel
+            juce::AudioBuffer<float>& buffer = *bufferToFill.buffer;
+            dsp_realtimeHostProcess (_liveHost, buffer.getWritePointer (0, bufferToFill.startSample), bufferToFill.numSamples);
+            for (int channel = 1; channel < buffer.getNumChannels(); channel++)
+                buffer.copyFrom (channel, bufferToFill.startSample, buffer, 0, bufferToFill.startSample, bufferToFill.numSamples);
+        }
+        else if (readerSource.get() == nullptr)
             bufferToFill.clearActiveBufferRegion();
         else
             transportSource.getNextAudioBlock (bufferToFill);
@@ -116,6 +166,10 @@ public:
     void releaseResources() override
     {
         transportSource.releaseResources();
+        
+        stopLive();
+        dsp_realtimeHostDestroy (_liveHost);
+        _liveHost = nullptr;
     }
 
     //....................................................................................................... paint
@@ -138,6 +192,9 @@ public:
         stopButton.setBounds ((getWidth()/2) + 5, 10, 100, 25);
         dspButton.setBounds (getWidth() - 110, 10, 100, 25);
         analyzeButton.setBounds (getWidth() - 220, 10, 100, 25);
+        liveButton.setBounds (120, 10, 100, 25);
+        rateSlider.setBounds (230, 10, getWidth()/2 - 345, 25);
+        depthSlider.setBounds ((getWidth()/2) + 115, 10, getWidth()/2 - 345, 25);
         
         _spectrogram.setBounds(10, getHeight()/2, getWidth() - 20, getHeight()/2 - 10);
         
@@ -163,23 +220,6 @@ public:
         if (source == &thumbnail)       thumbnailChanged();
     }
     
-    //....................................................................................................... createAudioBuffer
-    int createAudioBuffer(juce::int64 numSamples)
-    {
-        int returnCode = 0;
-        
-        juce::int64 numBytes = numSamples * sizeof(float);
-        
-        _inAudioPtr = (float*)malloc(numBytes);
-        if(_inAudioPtr == NULL)
-        {
-            returnCode = -1;
-            printf("NUDSP error in createAudioBuffer");
-        }        
-        
-        return returnCode;
-    }
-
 //........................................................................................................... PRIVATE
 //                                                PRIVATE
 //...........................................................................................................
@@ -187,14 +227,18 @@ public:
 private:
 #pragma mark MEMBER_VARIABLES
     //....................................................................................................... MEMBER VARIABLES
-    juce::AudioBuffer<float>            _inAudioBuffer;            // JUCE buffer object used for input
-    float*                              _inAudioPtr = NULL;        // pointer to a C buffer used for input
+    juce::AudioBuffer<float>            _inAudioBuffer;            // JUCE buffer object the C functions process in place
+    float*                              _inAudioStorage = nullptr; // aligned pool memory _inAudioBuffer refers to
+    dsp_BufferPool*                     _bufferPool = nullptr;     // recycles the audio memory across file opens
     int                                 _inNumSamples;             // total number of samples in input
     int                                 _sampleRate;
     
-    juce::AudioBuffer<float>            _outAudioBuffer;           // JUCE buffer object used for output
-    float*                              _outAudioPtr = NULL;       // pointer to a C buffer used for output
-    int                                 _outNumSamples;            // total number of samples in output
+    dsp_RealtimeHost*                   _liveHost = nullptr;       // live effects, created in prepareToPlay
+    int                                 _deviceRate = 0;           // sample rate _liveHost runs at
+    float*                              _liveStorage = nullptr;    // the file resampled to _deviceRate, if it differs
+    std::atomic<bool>                   _live { false };           // getNextAudioBlock plays through _liveHost
+    std::atomic<bool>                   _liveFeeding { false };    // keeps _liveFeeder running
+    std::thread                         _liveFeeder;               // pushes the loaded file into the host's ring
     
     Spectrogram                         _spectrogram;
 
@@ -304,6 +348,9 @@ private:
     //....................................................................................................... openFile
     void openFile(juce::File file)
     {
+        // the feeder reads the buffer that is about to be replaced
+        stopLive();
+        
         juce::AudioFormatReader* reader = formatManager.createReaderFor (file);
 
         if (reader != nullptr)
@@ -313,26 +360,40 @@ private:
             playButton.setEnabled (true);
             thumbnail.setSource (new juce::FileInputSource (file));    // [7]
                     
-            // SETUP AUDIO BUFFER THAT WE'LL PASS TO C FUNCTIONS
-            _inNumSamples = (int)reader->lengthInSamples;
-            _sampleRate = reader->sampleRate;
-            _outNumSamples = _inNumSamples; // this needs to be set from the C functions
-            if(0 == this->createAudioBuffer(_inNumSamples))
+            // READ AUDIO INTO THE JUCE BUFFER THAT THE C FUNCTIONS WORK ON DIRECTLY
+            // WAV and AIFF files are decoded by dsp.h straight out of a memory mapping, with 64-bit lengths; other
+            // formats go through the JUCE reader. A JUCE buffer holds at most 2^31 - 1 samples, so longer files are
+            // refused here rather than cut short (stream them with dsp_audioFileProcess instead).
+            // the previous file's memory goes back to the pool first, so reopening the same size reuses it
+            dsp_AudioFile audioFile;
+            bool mapped = dsp_audioFileOpen(&audioFile, file.getFullPathName().toRawUTF8(), 0) == DSP_SUCCESS;
+            long long numSamples = mapped ? audioFile.numFrames : (long long)reader->lengthInSamples;
+            
+            _sampleRate = mapped ? audioFile.sampleRate : (int)reader->sampleRate;
+            dsp_bufferRelease(_bufferPool, _inAudioStorage);
+            _inAudioStorage = nullptr;
+            _inNumSamples = 0;
+            
+            if (numSamples > 0 && numSamples <= std::numeric_limits<int>::max()
+                && dsp_bufferAcquire(_bufferPool, numSamples, &_inAudioStorage) == DSP_SUCCESS)
             {
-                // READ AUDIO INTO A JUCE BUFFER OBJECT
-                _inAudioBuffer = juce::AudioBuffer<float>(1, (int)reader->lengthInSamples);
-                _inAudioBuffer.clear();
-                reader->read(&_inAudioBuffer, 0, (int)reader->lengthInSamples, 0, true, true);
+                _inNumSamples = (int)numSamples;
+                _inAudioBuffer.setDataToReferTo (&_inAudioStorage, 1, _inNumSamples);
                 
-                // LOOP/COPY AUDIO DATA INTO C BUFFER
-                int i;
-                for(i = 0; i < reader->lengthInSamples; i++)
-                {
-                    _inAudioPtr[i] = _inAudioBuffer.getSample(0, i);
-                    //printf("%d = %f\n", i, *_inAudioPtr);
-                }
+                dsp_AudioView view;
+                if (mapped && dsp_audioFileView(&audioFile, 0, 0, numSamples, &view) == DSP_SUCCESS)
+                    dsp_audioViewRead(&view, _inAudioStorage);
+                else
+                    reader->read(&_inAudioBuffer, 0, _inNumSamples, 0, true, true);
+            }
+            else
+            {
+                _inAudioBuffer.setSize (1, 0);
             }
             
+            if (mapped)
+                dsp_audioFileClose(&audioFile);
+            
             // SET UP SPECTROGRAM
             if(_inNumSamples >= 1024)
             {
@@ -345,8 +406,9 @@ private:
         }
     }
     
-    //....................................................................................................... stopButtonClicked
-    void saveButtonClicked()
+    //....................................................................................................... saveButtonClicked
+    // returns whether the output file was written; a failed write leaves no file behind
+    bool saveButtonClicked()
     {
         // CREATE OUTPUT FILE
         // "~/juce_out.wav";
@@ -355,27 +417,39 @@ private:
             _outputFile.deleteFile();
         }
         
-        // CREATE JUCE AUDIOBUFFER OBJECT
-        _outAudioBuffer = juce::AudioBuffer<float>(1, (int)_outNumSamples);
+        // processing runs in place, so the input buffer holds the output
+        juce::AudioBuffer<float>& outAudioBuffer = _inAudioBuffer;
+        int numSamples = outAudioBuffer.getNumSamples();
+        if (numSamples <= 0)
+            return false;
         
-        // LOOP/COPY AUDIO DATA INTO AUDIOBUFFER OBJECT
-        int i;
-        for(i = 0; i < _outNumSamples; i++)
+        // WRITE A 24-BIT FILE
+        // the file is created at its final size and mapped; TPDF dither onto the 24-bit grid is written straight
+        // into the mapped samples, so there is no intermediate buffer. It keeps the rate of the file it came from.
+        dsp_AudioFile audioFile;
+        if (dsp_audioFileCreate(&audioFile, _outputFile.getFullPathName().toRawUTF8(), DSP_FILE_WAV,
+                                DSP_ENCODING_PCM24, 1, _sampleRate, numSamples) != DSP_SUCCESS)
         {
-            _outAudioBuffer.setSample(0, i, _outAudioPtr[i]);
+            printf("Error: could not create the output file");
+            return false;
         }
         
-        // WRITE BUFFER TO FILE
-        juce::WavAudioFormat format;
-        std::unique_ptr<juce::AudioFormatWriter> writer;
-        writer.reset (format.createWriterFor (new juce::FileOutputStream (_outputFile),
-                                              44100.0,
-                                              _outAudioBuffer.getNumChannels(),
-                                              24,
-                                              {},
-                                              0));
-        if (writer != nullptr)
-            writer->writeFromAudioSampleBuffer (_outAudioBuffer, 0, _outAudioBuffer.getNumSamples());
+        // a view that is not direct has no samples pointer, and the requantize then fails rather than writing
+        dsp_AudioView view;
+        int result = dsp_audioFileView(&audioFile, 0, 0, numSamples, &view);
+        if (result == DSP_SUCCESS)
+            result = dsp_requantizePCM24(outAudioBuffer.getWritePointer(0), numSamples, (uint8_t*) view.samples, DSP_DITHER_TPDF, 1);
+        int closeResult = dsp_audioFileClose(&audioFile);
+        if (result == DSP_SUCCESS)
+            result = closeResult;
+        
+        if (result != DSP_SUCCESS)
+        {
+            _outputFile.deleteFile();
+            printf("Error: could not write the output file (error %d)", result);
+            return false;
+        }
+        return true;
     }
     
     //....................................................................................................... playButtonClicked
@@ -390,46 +464,108 @@ private:
         changeState (Stopping);
     }
     
-
-    // ADDED: 9.25 Create a member variable to store the output buffer
-    float* _outputAudioPtr = nullptr;
-
     //....................................................................................................... dspButtonClicked
     void dspButtonClicked()
     {
-        int result = DSP_SUCCESS;
-     
-        _outNumSamples = _inNumSamples;
+        int result = DSP_ERR_MEMBUFFER;
+        stopLive();
         
-        _outAudioPtr = (float*)malloc(_outNumSamples * sizeof(float));
-       
-        if (_outAudioPtr != NULL)
-        {
-            result = dspa_tremolo(_inAudioPtr, _inNumSamples, _outAudioPtr, 4, 8, 60, 44100);
-        }
-        else
+        // the C function reads and writes the JUCE channel directly, no copies or allocations
+        if (_inAudioBuffer.getNumSamples() > 0)
         {
-            result = DSP_ERR_MEMBUFFER;
+            DspChannelView audio = dspChannelView (_inAudioBuffer, 0);
+            result = dspa_tremolo(audio.samples, audio.numSamples, audio.samples, 4, 8, 60, _sampleRate);
         }
               
         // UPDATE VIEWS
         if(result == DSP_SUCCESS)
         {
             // save to file and re-open it
-            saveButtonClicked();
-            openFile(_outputFile);
-            
-            // clean up previously used buffer
-            if(_outAudioPtr != NULL)
-            {
-                free(_outAudioPtr);
-                _outAudioPtr = NULL;
-            } 
+            if (saveButtonClicked())
+                openFile(_outputFile);
         } else {
             printf("Error: DSP processing did not work");
         }
     }
     
+    //....................................................................................................... liveButtonClicked
+    void liveButtonClicked()
+    {
+        if (_live.load())
+            stopLive();
+        else
+            startLive();
+    }
+    
+    //....................................................................................................... startLive
+    // loops the loaded file through the real-time host. Only this thread sends parameters, so the host's queue
+    // keeps its single producer.
+    void startLive()
+    {
+        if (_liveHost == nullptr || _inNumSamples <= 0)
+            return;
+        
+        // the host plays at the device rate; a file at another rate is converted into pool memory first, or refused
+        // when the rates are too far apart for dsp_resample
+        float* source = _inAudioStorage;
+        long long length = _inNumSamples;
+        if (_sampleRate != _deviceRate)
+        {
+            length = dsp_resampleLength (_inNumSamples, _sampleRate, _deviceRate);
+            if (length <= 0
+                || dsp_bufferAcquire (_bufferPool, length, &_liveStorage) != DSP_SUCCESS
+                || dsp_resample (_inAudioStorage, _inNumSamples, _sampleRate, _liveStorage, _deviceRate) != DSP_SUCCESS)
+            {
+                dsp_bufferRelease (_bufferPool, _liveStorage);
+                _liveStorage = nullptr;
+                printf("Error: cannot play a %d Hz file live on a %d Hz device", _sampleRate, _deviceRate);
+                return;
+            }
+            source = _liveStorage;
+        }
+        
+        changeState (Stopping);
+        // the flush drops what the last session left in the ring, but none of what the new feeder pushes
+        dsp_realtimeHostSetParam (_liveHost, DSP_PARAM_FLUSH, 0);
+        dsp_realtimeHostSetParam (_liveHost, DSP_PARAM_TREMOLO_RATE, (float) rateSlider.getValue());
+        dsp_realtimeHostSetParam (_liveHost, DSP_PARAM_TREMOLO_DEPTH, (float) depthSlider.getValue());
+        
+        _liveFeeding = true;
+        _liveFeeder = std::thread ([this, source, length]
+        {
+            long long position = 0;
+            while (_liveFeeding.load())
+            {
+                long long pushed = dsp_realtimeHostPush (_liveHost, source + position, length - position);
+                position = (position + pushed) % length;
+                if (pushed == 0)
+                    std::this_thread::sleep_for (std::chrono::milliseconds (2));
+            }
+        });
+        
+        _live = true;
+        liveButton.setButtonText ("Live off");
+    }
+    
+    //....................................................................................................... stopLive
+    void stopLive()
+    {
+        _live = false;
+        _liveFeeding = false;
+        if (_liveFeeder.joinable())
+            _liveFeeder.join();
+        dsp_bufferRelease (_bufferPool, _liveStorage);
+        _liveStorage = nullptr;
+        liveButton.setButtonText ("Live");
+    }
+    
+    //....................................................................................................... sendLiveParam
+    void sendLiveParam (int param, float value)
+    {
+        if (_live.load())
+            dsp_realtimeHostSetParam (_liveHost, param, value);
+    }
+    
     //....................................................................................................... analyzeButtonClicked
     void analyzeButtonClicked()
     {
@@ -444,6 +580,9 @@ private:
     juce::TextButton stopButton;
     juce::TextButton dspButton;
     juce::TextButton analyzeButton;
+    juce::TextButton liveButton;
+    juce::Slider rateSlider;
+    juce::Slider depthSlider;
     
     juce::AudioFormatManager formatManager;
     std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
@@ -0,0 +1,594 @@
+/*
+  ==================================================================================================================
+
+    dsp_batch.cpp
+
+    DESCRIPTION: Headless batch processor. Applies a chain of dsp.h operations to every WAV and AIFF file in a
+                 directory and writes the results to another directory, then reports the throughput.
+
+                 Work is scheduled on a pool of workers with one task deque each. A worker pops its own newest
+                 task and, when it runs dry, steals the oldest task of another worker. Each file is a task; every
+                 step of its chain splits long channels into chunks that are tasks of their own, so a few large
+                 files spread across all workers just like many small ones do.
+
+    USAGE:       dsp_batch [options] <inputDir> <outputDir>
+
+                 The chain runs in the order the options are given:
+                    --normalize <dB>                    scale so the peak of all channels sits at dB
+                    --gain <dB>                         change the level by dB (-100 to 20)
+                    --fade-in <ms>                      fade in over the first ms milliseconds
+                    --fade-out <ms>                     fade out over the last ms milliseconds
+                    --tremolo <startHz> <endHz> <depth> tremolo sweeping from startHz to endHz, depth in %
+                    --reverse                           reverse the file
+                    --resample <Hz>                     convert to a sample rate of Hz
+
+                 Other options:
+                    --fade-type linear|equalpower|sshape    curve of the fades that follow (default linear)
+                    --threads <n>                           number of workers (default: hardware threads)
+
+                 Reads and writes 16, 24 and 32 bit PCM and 32 bit float WAV, RF64 and AIFF files through the
+                 memory-mapped file support of dsp.h; the output keeps the format of the input.
+
+  ==================================================================================================================
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dsp.h"
+
+namespace fs = std::filesystem;
+
+#define     BATCH_CHUNK                       65536     // samples per chunk task
+
+#pragma mark FILE_IO
+
+//.................................................................................................................. AudioData
+// A decoded file: one float buffer per channel plus what is needed to write it back in the same format.
+struct AudioData
+{
+    int                             fileType = DSP_FILE_WAV;
+    int                             encoding = DSP_ENCODING_PCM16;
+    int                             sampleRate = 0;
+    std::vector<std::vector<float>> channels;
+};
+
+//.................................................................................................................. readAudio
+// decodes a file through the library's memory-mapped reader; each channel is converted straight out of the mapping
+static bool readAudio(const fs::path& path, AudioData& audio, std::string& error)
+{
+    dsp_AudioFile file;
+    int err = dsp_audioFileOpen(&file, path.string().c_str(), 0);
+    if (err != DSP_SUCCESS) {
+        error = (err == DSP_ERR_FILEIO) ? "cannot open" : "unsupported file format";
+        return false;
+    }
+
+    if (file.numFrames == 0) {
+        dsp_audioFileClose(&file);
+        error = "unsupported length";
+        return false;
+    }
+
+    audio.fileType = file.fileType;
+    audio.encoding = file.encoding;
+    audio.sampleRate = file.sampleRate;
+    audio.channels.assign(file.numChannels, std::vector<float>(file.numFrames));
+    for (int c = 0; c < file.numChannels; c++) {
+        dsp_AudioView view;
+        dsp_audioFileView(&file, c, 0, file.numFrames, &view);
+        dsp_audioViewRead(&view, audio.channels[c].data());
+    }
+
+    dsp_audioFileClose(&file);
+    return true;
+}
+
+//.................................................................................................................. writeAudio
+// writes the file in the type and encoding it was read in; WAV data over 4 GB becomes RF64
+static bool writeAudio(const fs::path& path, AudioData& audio, std::string& error)
+{
+    int numChannels = (int)audio.channels.size();
+    long long numFrames = (long long)audio.channels[0].size();
+
+    dsp_AudioFile file;
+    if (dsp_audioFileCreate(&file, path.string().c_str(), audio.fileType, audio.encoding, numChannels,
+                            audio.sampleRate, numFrames) != DSP_SUCCESS) {
+        error = "cannot write";
+        return false;
+    }
+
+    for (int c = 0; c < numChannels; c++) {
+        dsp_AudioView view;
+        dsp_audioFileView(&file, c, 0, numFrames, &view);
+        dsp_audioViewWrite(&view, audio.channels[c].data());
+    }
+
+    if (dsp_audioFileClose(&file) != DSP_SUCCESS) {
+        error = "cannot write";
+        return false;
+    }
+    return true;
+}
+
+#pragma mark SCHEDULER
+
+//.................................................................................................................. Scheduler
+// Work-stealing task pool. Tasks submitted from a worker go to the back of that worker's deque; the owner takes
+// from the back (newest first, which keeps a file's chunks on a warm cache), thieves take from the front.
+class Scheduler
+{
+public:
+    typedef std::function<void()> Task;
+
+    explicit Scheduler(int numWorkers)
+    {
+        for (int i = 0; i < numWorkers; i++) {
+            queues.emplace_back(new Queue);
+        }
+    }
+
+    // queues a task; from outside the pool the tasks are dealt round-robin
+    void submit(Task task)
+    {
+        pending.fetch_add(1);
+        int target = (self >= 0) ? self : (int)(nextQueue++ % queues.size());
+        std::lock_guard<std::mutex> lk(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+
+    // runs all tasks, including the ones they submit, and returns when none are left
+    void run()
+    {
+        std::vector<std::thread> threads;
+        for (int i = 1; i < (int)queues.size(); i++) {
+            threads.emplace_back(&Scheduler::work, this, i);
+        }
+        work(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    long long steals() const { return stolen.load(); }
+
+private:
+    struct Queue
+    {
+        std::mutex          lock;
+        std::deque<Task>    tasks;
+    };
+
+    bool take(int index, bool fromBack, Task& task)
+    {
+        std::lock_guard<std::mutex> lk(queues[index]->lock);
+        std::deque<Task>& tasks = queues[index]->tasks;
+        if (tasks.empty()) {
+            return false;
+        }
+        if (fromBack) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        } else {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        return true;
+    }
+
+    void work(int index)
+    {
+        self = index;
+        int n = (int)queues.size();
+        unsigned int victim = index * 7919u + 1;
+
+        while (pending.load() > 0) {
+            Task task;
+            bool found = take(index, true, task);
+            for (int tries = 0; !found && tries < n - 1; tries++) {
+                victim = victim * 1103515245u + 12345u;
+                int other = (int)((victim >> 8) % n);
+                if (other != index && take(other, false, task)) {
+                    found = true;
+                    stolen.fetch_add(1);
+                }
+            }
+
+            if (found) {
+                task();
+                pending.fetch_sub(1);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        self = -1;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<long long>              pending{0};
+    std::atomic<long long>              stolen{0};
+    std::atomic<unsigned int>           nextQueue{0};
+    static thread_local int             self;
+};
+
+thread_local int Scheduler::self = -1;
+
+#pragma mark CHAIN
+
+//.................................................................................................................. Op
+enum OpType { OP_PEAK, OP_NORMALIZE, OP_GAIN, OP_FADE_IN, OP_FADE_OUT, OP_TREMOLO, OP_REVERSE, OP_RESAMPLE };
+
+struct Op
+{
+    OpType  type;
+    float   value = 0;                                  // dB for gain/normalize, ms for fades, Hz for resample
+    float   lfoStartRate = 0, lfoEndRate = 0, lfoDepth = 0;
+    short   fadeType = FADE_TYPE_LINEAR;
+};
+
+//.................................................................................................................. FileJob
+// One file moving through the chain. step is the index of the operation being applied; chunksLeft counts the
+// chunk tasks of that step still running, and whichever finishes last moves the file on.
+struct FileJob
+{
+    fs::path                        inPath, outPath;
+    AudioData                       audio;
+    std::vector<std::vector<float>> scratch;            // reverse and resample write here, then swap
+    size_t                          step = 0;
+    std::atomic<long long>          chunksLeft{0};
+    std::atomic<unsigned int>       peakBits{0};        // bit pattern of the largest |sample|, see opChunk
+    float                           normalizeGain = 0;  // dB change found by OP_PEAK for OP_NORMALIZE
+    std::atomic<int>                err{DSP_SUCCESS};
+    std::string                     error;
+    long long                       fileBytes = 0;
+};
+
+struct Stats
+{
+    std::atomic<long long>  filesDone{0};
+    std::atomic<long long>  filesFailed{0};
+    std::atomic<long long>  samples{0};                 // frames * channels
+    std::atomic<long long>  bytes{0};
+    std::atomic<long long>  audioMicros{0};             // duration of the processed audio
+};
+
+static std::vector<Op>  chain;
+static Stats            stats;
+
+static void runStep(Scheduler& sched, std::shared_ptr<FileJob> job);
+
+//.................................................................................................................. opChunk
+// applies chain[job->step] to samples [begin, end) of one channel
+static void opChunk(FileJob& job, const Op& op, int channel, long long begin, long long end)
+{
+    std::vector<float>& x = job.audio.channels[channel];
+    long long length = (long long)x.size();
+    int n = (int)(end - begin);
+    int err = DSP_SUCCESS;
+
+    switch (op.type) {
+    case OP_PEAK:
+    {
+        float peak = 0.0f;
+        for (long long i = begin; i < end; i++) {
+            float a = fabsf(x[i]);
+            peak = (a > peak) ? a : peak;
+        }
+        // non-negative floats order the same way as their bit patterns
+        unsigned int bits;
+        memcpy(&bits, &peak, sizeof(bits));
+        unsigned int prev = job.peakBits.load();
+        while (prev < bits && !job.peakBits.compare_exchange_weak(prev, bits)) {
+        }
+        break;
+    }
+
+    case OP_NORMALIZE:
+    case OP_GAIN:
+        // dsp_gainChange rejects a change of exactly 0 dB, which leaves the samples as they are anyway
+        if (op.value != 0) {
+            err = dsp_gainChange(&x[begin], n, &x[begin], op.value);
+        }
+        break;
+
+    case OP_FADE_IN:
+    {
+        // only the head changes, so hand dsp_fadeIn just the fade and the sample after it
+        long long fadeSamples = (long long)op.value * job.audio.sampleRate / 1000 + 1;
+        if (fadeSamples > length) {
+            fadeSamples = length;
+        }
+        err = dsp_fadeIn(x.data(), (int)fadeSamples, x.data(), (int)op.value, job.audio.sampleRate, op.fadeType);
+        break;
+    }
+
+    case OP_FADE_OUT:
+    {
+        // dsp_fadeOut fades the start of its buffer and silences the rest, so hand it the tail: the fade
+        // covers all but the last sample, which ends up at zero
+        long long fadeSamples = (long long)op.value * job.audio.sampleRate / 1000 + 1;
+        if (fadeSamples > length) {
+            fadeSamples = length;
+        }
+        float* tail = x.data() + length - fadeSamples;
+        err = dsp_fadeOut(tail, (int)fadeSamples, tail, (int)op.value, job.audio.sampleRate, op.fadeType);
+        break;
+    }
+
+    case OP_TREMOLO:
+    {
+        dsp_TremoloState state;
+        err = dspa_tremoloInit(&state, op.lfoStartRate, op.lfoEndRate, op.lfoDepth, length, job.audio.sampleRate);
+        if (err == DSP_SUCCESS) {
+            // tiles after the first start the LFO where a run over the whole buffer would be
+            err = dspa_tremoloSeek(&state, begin);
+        }
+        if (err == DSP_SUCCESS) {
+            err = dspa_tremoloProcess(&state, &x[begin], n, &x[begin]);
+        }
+        break;
+    }
+
+    case OP_REVERSE:
+        err = dsp_reverse(&x[length - end], n, &job.scratch[channel][begin]);
+        break;
+
+    case OP_RESAMPLE:
+        // [begin, end) is a range of the output here, see runStep
+        err = dsp_resampleRange(x.data(), length, job.audio.sampleRate, &job.scratch[channel][begin], (int)op.value,
+                                begin, end);
+        break;
+    }
+
+    if (err != DSP_SUCCESS) {
+        job.err.store(err);
+    }
+}
+
+//.................................................................................................................. chunked
+// whether a step can be split into chunks; the fades only touch a short stretch of the file
+static bool chunked(const Op& op)
+{
+    return op.type != OP_FADE_IN && op.type != OP_FADE_OUT;
+}
+
+//.................................................................................................................. finishStep
+static void finishStep(Scheduler& sched, std::shared_ptr<FileJob> job)
+{
+    const Op& op = chain[job->step];
+
+    if (op.type == OP_PEAK) {
+        // the next step is the matching OP_NORMALIZE; give it the gain that puts the peak at the target
+        unsigned int bits = job->peakBits.load();
+        float peak;
+        memcpy(&peak, &bits, sizeof(peak));
+        float peakdB = (peak > 0) ? (float)(20.0 * log10(peak)) : -180.0f;
+        job->normalizeGain = chain[job->step + 1].value - peakdB;
+    } else if (op.type == OP_REVERSE || op.type == OP_RESAMPLE) {
+        job->audio.channels.swap(job->scratch);
+        job->scratch.clear();
+        if (op.type == OP_RESAMPLE) {
+            job->audio.sampleRate = (int)op.value;
+        }
+    }
+
+    job->step++;
+    runStep(sched, job);
+}
+
+//.................................................................................................................. runStep
+// starts chain[job->step] on a file, or writes the file out when the chain is done
+static void runStep(Scheduler& sched, std::shared_ptr<FileJob> job)
+{
+    if (job->err.load() != DSP_SUCCESS || job->step == chain.size()) {
+        std::string error = job->error;
+        if (job->err.load() != DSP_SUCCESS) {
+            error = "dsp error " + std::to_string(job->err.load());
+        } else if (!writeAudio(job->outPath, job->audio, error)) {
+            job->err.store(DSP_ERR_UNDEFINED);
+        }
+
+        if (job->err.load() != DSP_SUCCESS) {
+            fprintf(stderr, "%s: %s\n", job->inPath.string().c_str(), error.c_str());
+            stats.filesFailed++;
+        } else {
+            long long frames = (long long)job->audio.channels[0].size();
+            stats.filesDone++;
+            stats.samples += frames * (long long)job->audio.channels.size();
+            stats.bytes += job->fileBytes;
+            stats.audioMicros += frames * 1000000 / job->audio.sampleRate;
+        }
+        return;
+    }
+
+    Op op = chain[job->step];
+    int numChannels = (int)job->audio.channels.size();
+    long long length = (long long)job->audio.channels[0].size();
+    long long span = length;                            // samples the chunks cover: the output's for resample
+
+    if (op.type == OP_NORMALIZE) {
+        op.value = job->normalizeGain;
+        if (op.value < -100 || op.value > 20) {
+            job->err.store(DSP_ERR_DBRANGE);
+            runStep(sched, job);
+            return;
+        }
+    } else if (op.type == OP_REVERSE) {
+        job->scratch.assign(numChannels, std::vector<float>(length));
+    } else if (op.type == OP_RESAMPLE) {
+        long long resampled = dsp_resampleLength(length, job->audio.sampleRate, (int)op.value);
+        if (resampled < 0) {
+            job->err.store(DSP_INVALID_PARAMETER);
+            runStep(sched, job);
+            return;
+        }
+        job->scratch.assign(numChannels, std::vector<float>(resampled));
+        span = resampled;
+    }
+
+    long long chunkSize = chunked(op) ? BATCH_CHUNK : span;
+    long long numChunks = (span + chunkSize - 1) / chunkSize;
+    job->chunksLeft.store(numChunks * numChannels);
+
+    for (int c = 0; c < numChannels; c++) {
+        for (long long k = 0; k < numChunks; k++) {
+            long long begin = k * chunkSize;
+            long long end = (begin + chunkSize < span) ? begin + chunkSize : span;
+            sched.submit([&sched, job, op, c, begin, end] {
+                opChunk(*job, op, c, begin, end);
+                if (job->chunksLeft.fetch_sub(1) == 1) {
+                    finishStep(sched, job);
+                }
+            });
+        }
+    }
+}
+
+#pragma mark MAIN
+
+//.................................................................................................................. usage
+static int usage(void)
+{
+    fprintf(stderr,
+            "usage: dsp_batch [options] <inputDir> <outputDir>\n"
+            "  chain (applied in the order given):\n"
+            "    --normalize <dB> | --gain <dB> | --fade-in <ms> | --fade-out <ms>\n"
+            "    --tremolo <startHz> <endHz> <depth%%> | --reverse | --resample <Hz>\n"
+            "  options:\n"
+            "    --fade-type linear|equalpower|sshape   --threads <n>\n");
+    return 2;
+}
+
+//.................................................................................................................. main
+int main(int argc, char** argv)
+{
+    std::vector<std::string> dirs;
+    short fadeType = FADE_TYPE_LINEAR;
+    int numThreads = (int)std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        int left = argc - 1 - i;
+        Op op;
+
+        if (arg == "--normalize" && left >= 1) {
+            op.type = OP_PEAK;
+            chain.push_back(op);
+            op.type = OP_NORMALIZE;
+            op.value = (float)atof(argv[++i]);
+            chain.push_back(op);
+        } else if (arg == "--gain" && left >= 1) {
+            op.type = OP_GAIN;
+            op.value = (float)atof(argv[++i]);
+            chain.push_back(op);
+        } else if ((arg == "--fade-in" || arg == "--fade-out") && left >= 1) {
+            op.type = (arg == "--fade-in") ? OP_FADE_IN : OP_FADE_OUT;
+            op.value = (float)atoi(argv[++i]);
+            op.fadeType = fadeType;
+            chain.push_back(op);
+        } else if (arg == "--tremolo" && left >= 3) {
+            op.type = OP_TREMOLO;
+            op.lfoStartRate = (float)atof(argv[++i]);
+            op.lfoEndRate = (float)atof(argv[++i]);
+            op.lfoDepth = (float)atof(argv[++i]);
+            chain.push_back(op);
+        } else if (arg == "--reverse") {
+            op.type = OP_REVERSE;
+            chain.push_back(op);
+        } else if (arg == "--resample" && left >= 1) {
+            op.type = OP_RESAMPLE;
+            op.value = (float)atoi(argv[++i]);
+            if (op.value <= 0) {
+                return usage();
+            }
+            chain.push_back(op);
+        } else if (arg == "--fade-type" && left >= 1) {
+            std::string type = argv[++i];
+            if (type == "linear") {
+                fadeType = FADE_TYPE_LINEAR;
+            } else if (type == "equalpower") {
+                fadeType = FADE_TYPE_EQUALPOWER;
+            } else if (type == "sshape") {
+                fadeType = FADE_TYPE_SSHAPE;
+            } else {
+                return usage();
+            }
+        } else if (arg == "--threads" && left >= 1) {
+            numThreads = atoi(argv[++i]);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            return usage();
+        } else {
+            dirs.push_back(arg);
+        }
+    }
+
+    if (dirs.size() != 2 || chain.empty()) {
+        return usage();
+    }
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+
+    std::error_code ec;
+    fs::create_directories(dirs[1], ec);
+
+    Scheduler sched(numThreads);
+    std::vector<fs::path> inputs;
+    for (const auto& entry : fs::directory_iterator(dirs[0], ec)) {
+        std::string ext = entry.path().extension().string();
+        for (auto& ch : ext) {
+            ch = (char)tolower(ch);
+        }
+        if (entry.is_regular_file() && (ext == ".wav" || ext == ".aif" || ext == ".aiff")) {
+            inputs.push_back(entry.path());
+        }
+    }
+    if (ec) {
+        fprintf(stderr, "%s: %s\n", dirs[0].c_str(), ec.message().c_str());
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // each file starts as one task that decodes it and then fans its chain out into chunk tasks
+    for (const fs::path& input : inputs) {
+        fs::path output = fs::path(dirs[1]) / input.filename();
+        sched.submit([&sched, input, output] {
+            auto job = std::make_shared<FileJob>();
+            job->inPath = input;
+            job->outPath = output;
+
+            std::error_code sizeError;
+            job->fileBytes = (long long)fs::file_size(input, sizeError);
+            if (!readAudio(input, job->audio, job->error)) {
+                fprintf(stderr, "%s: %s\n", input.string().c_str(), job->error.c_str());
+                stats.filesFailed++;
+                return;
+            }
+            runStep(sched, job);
+        });
+    }
+
+    sched.run();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double audioSeconds = stats.audioMicros.load() / 1e6;
+
+    printf("files:       %lld processed, %lld failed\n", stats.filesDone.load(), stats.filesFailed.load());
+    printf("audio:       %.1f s in %lld samples, %.1f MB read\n", audioSeconds, stats.samples.load(), stats.bytes.load() / 1e6);
+    printf("wall time:   %.3f s on %d workers (%lld steals)\n", seconds, numThreads, sched.steals());
+    if (seconds > 0) {
+        printf("throughput:  %.1f Msamples/s, %.1f MB/s, %.0fx realtime\n",
+               stats.samples.load() / seconds / 1e6, stats.bytes.load() / seconds / 1e6, audioSeconds / seconds);
+    }
+
+    return stats.filesFailed.load() == 0 ? 0 : 1;
+}
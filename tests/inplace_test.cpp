@@ -0,0 +1,156 @@
+/*
+  ==================================================================================================================
+
+    inplace_test.cpp
+
+    DESCRIPTION: Checks the IN-PLACE PROCESSING guarantee of dsp.h. Every function that takes an iAudioPtr and an
+                 oAudioPtr is run with the same pointer for both and must give exactly what it gives into a separate
+                 buffer, on one thread and on the worker pool. dsp_reverse is also checked against a reference
+                 reversal and must reject partially overlapping buffers without touching them.
+
+    USAGE:       make -C tests check, or inplace_test on its own. Exits with 1 if any check fails.
+
+  ==================================================================================================================
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <functional>
+#include <vector>
+
+#include "dsp.h"
+
+// 0, 1 and 2, odd and even, and above DSP_PARALLEL_CHUNK (both parities) so the pool splits the work
+static const int lengths[] = { 0, 1, 2, 3, 4, 1001, 1000, 2 * DSP_PARALLEL_CHUNK + 1, 3 * DSP_PARALLEL_CHUNK };
+
+static int failures = 0;
+
+//.................................................................................................................. check
+static void check(bool ok, const char* what, int length, int threads)
+{
+    if (!ok) {
+        printf("FAIL: %s (length %d, %d thread%s)\n", what, length, threads, (threads == 1) ? "" : "s");
+        failures++;
+    }
+}
+
+//.................................................................................................................. testSignal
+// a test signal below full scale, so that the gain and normalize calls stay in range
+static std::vector<float> testSignal(int length)
+{
+    std::vector<float> x(length);
+    for (int i = 0; i < length; i++) {
+        x[i] = 0.5f * sinf(0.01f * i) + 0.1f * sinf(0.37f * i + 1.0f);
+    }
+    return x;
+}
+
+//.................................................................................................................. compareInPlace
+// runs op(in, n, out) out of place and in place and requires the same return code and the same samples
+typedef std::function<int(float*, int, float*)> Op;
+
+static void compareInPlace(const char* name, const Op& op, int length, int threads)
+{
+    // one spare sample, so that a length of 0 still passes valid pointers
+    std::vector<float> in = testSignal(length);
+    in.push_back(0.0f);
+    std::vector<float> out(length + 1);
+    std::vector<float> inPlace = in;
+
+    int errOut = op(in.data(), length, out.data());
+    int errIn = op(inPlace.data(), length, inPlace.data());
+
+    char what[128];
+    snprintf(what, sizeof(what), "%s returns %d in place but %d out of place", name, errIn, errOut);
+    check(errIn == errOut, what, length, threads);
+
+    if (errOut == DSP_SUCCESS) {
+        snprintf(what, sizeof(what), "%s gives different samples in place", name);
+        check(memcmp(out.data(), inPlace.data(), length * sizeof(float)) == 0, what, length, threads);
+    }
+}
+
+//.................................................................................................................. testReverse
+static void testReverse(int length, int threads)
+{
+    std::vector<float> x = testSignal(length);
+    x.push_back(0.0f);
+    std::vector<float> reversed = x;
+    for (int i = 0; i < length / 2; i++) {
+        float t = reversed[i];
+        reversed[i] = reversed[length - 1 - i];
+        reversed[length - 1 - i] = t;
+    }
+
+    int err = dsp_reverse(x.data(), length, x.data());
+    if (length == 0) {
+        check(err == DSP_INVALID_PARAMETER, "dsp_reverse accepts an empty buffer", length, threads);
+        return;
+    }
+
+    check(err == DSP_SUCCESS, "dsp_reverse fails in place", length, threads);
+    check(x == reversed, "dsp_reverse in place is not the reversal", length, threads);
+
+    // a partial overlap in either direction is rejected and leaves the samples alone
+    if (length >= 2) {
+        std::vector<float> buffer = testSignal(length + 1);
+        std::vector<float> before = buffer;
+        check(dsp_reverse(buffer.data(), length, buffer.data() + 1) == DSP_INVALID_PARAMETER,
+              "dsp_reverse accepts an output overlapping the end of the input", length, threads);
+        check(dsp_reverse(buffer.data() + 1, length, buffer.data()) == DSP_INVALID_PARAMETER,
+              "dsp_reverse accepts an output overlapping the start of the input", length, threads);
+        check(buffer == before, "dsp_reverse writes to a partially overlapping buffer", length, threads);
+    }
+}
+
+//.................................................................................................................. main
+int main(void)
+{
+    static const short fadeTypes[3] = { FADE_TYPE_LINEAR, FADE_TYPE_EQUALPOWER, FADE_TYPE_SSHAPE };
+
+    for (int threads : { 1, 4 }) {
+        dsp_setThreadCount(threads);
+
+        for (int length : lengths) {
+            testReverse(length, threads);
+
+            compareInPlace("dsp_reverse", [](float* in, int n, float* out) {
+                return dsp_reverse(in, n, out);
+            }, length, threads);
+
+            compareInPlace("dsp_gainChange", [](float* in, int n, float* out) {
+                return dsp_gainChange(in, n, out, -6.0f);
+            }, length, threads);
+
+            compareInPlace("dsp_normalize", [](float* in, int n, float* out) {
+                return dsp_normalize(in, n, out, -1.0f);
+            }, length, threads);
+
+            for (short fadeType : fadeTypes) {
+                compareInPlace("dsp_fadeIn", [fadeType](float* in, int n, float* out) {
+                    return dsp_fadeIn(in, n, out, 250, 48000, fadeType);
+                }, length, threads);
+
+                compareInPlace("dsp_fadeOut", [fadeType](float* in, int n, float* out) {
+                    return dsp_fadeOut(in, n, out, 250, 48000, fadeType);
+                }, length, threads);
+            }
+
+            compareInPlace("dspa_tremolo", [](float* in, int n, float* out) {
+                return dspa_tremolo(in, n, out, 2, 9, 60, 48000);
+            }, length, threads);
+
+            compareInPlace("dspa_tremoloProcess", [](float* in, int n, float* out) {
+                dsp_TremoloState state;
+                int err = dspa_tremoloInit(&state, 3, 5, 80, 96000, 48000);
+                return (err == DSP_SUCCESS) ? dspa_tremoloProcess(&state, in, n, out) : err;
+            }, length, threads);
+        }
+    }
+
+    dsp_setThreadCount(1);
+
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, (failures == 1) ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/*
+  ==================================================================================================================
+
+    precision_test.cpp
+
+    DESCRIPTION: Checks every precision tier of dsp.h against libm. Each of sin, cos, exp2, log2 and sqrt is swept
+                 over about a million arguments at every tier and at every SIMD level the CPU supports, and the
+                 largest error is compared with the bound published in the PRECISION TIERS table of dsp.h. The
+                 results of a tier must also be the same at every SIMD level, and the edges of the domains must
+                 give the documented values.
+
+    USAGE:       make -C tests check, or precision_test on its own. Exits with 1 if any check fails.
+
+  ==================================================================================================================
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "dsp.h"
+
+//.................................................................................................................. bounds
+// the PRECISION TIERS table of dsp.h, one row per function, columns EXACT, HIGH, FAST
+static const double bounds[5][3] = {
+    { 3.0e-8, 2.1e-7, 7.2e-7 },     // sin
+    { 3.0e-8, 2.1e-7, 7.2e-7 },     // cos
+    { 6.0e-8, 9.8e-8, 2.4e-7 },     // exp2
+    { 6.0e-8, 8.5e-8, 9.2e-8 },     // log2
+    { 5.9e-8, 5.9e-8, 5.9e-8 },     // sqrt
+};
+
+static const char*  functionNames[5] = { "sin", "cos", "exp2", "log2", "sqrt" };
+static const char*  precisionNames[3] = { "EXACT", "HIGH", "FAST" };
+static const char*  levelNames[4] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+
+static int failures = 0;
+
+//.................................................................................................................. check
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+//.................................................................................................................. evaluate
+static void evaluate(int function, const float* in, long long n, float* out)
+{
+    switch (function) {
+    case DSP_MATH_SIN:  dsp_sinArray(in, n, out);   break;
+    case DSP_MATH_COS:  dsp_cosArray(in, n, out);   break;
+    case DSP_MATH_EXP2: dsp_exp2Array(in, n, out);  break;
+    case DSP_MATH_LOG2: dsp_log2Array(in, n, out);  break;
+    default:            dsp_sqrtArray(in, n, out);  break;
+    }
+}
+
+//.................................................................................................................. reference
+static double reference(int function, double x)
+{
+    switch (function) {
+    case DSP_MATH_SIN:  return sin(x);
+    case DSP_MATH_COS:  return cos(x);
+    case DSP_MATH_EXP2: return exp2(x);
+    case DSP_MATH_LOG2: return log2(x);
+    default:            return sqrt(x);
+    }
+}
+
+//.................................................................................................................. arguments
+// 256 blocks of 4096 arguments: a uniform grid for sin and cos (radians within +-64 pi) and exp2 (-149 to 127); for
+// log2 and sqrt one binary exponent per block (2^-149 to 2^106, the first block denormal) with the mantissas spread
+// evenly across it
+static std::vector<float> arguments(int function)
+{
+    const int blockSize = 4096;
+    const int numBlocks = 256;
+    double pi = 3.141592653589793238462643383279502884197;
+    std::vector<float> in(blockSize * numBlocks);
+
+    for (int b = 0; b < numBlocks; b++) {
+        for (int i = 0; i < blockSize; i++) {
+            double u = (b * (double)blockSize + i) / ((double)numBlocks * blockSize);
+            float x;
+            switch (function) {
+            case DSP_MATH_SIN:
+            case DSP_MATH_COS:  x = (float)(-64 * pi + 128 * pi * u);                   break;
+            case DSP_MATH_EXP2: x = (float)(-149 + 276 * u);                            break;
+            default:            x = (b == 0) ? (float)ldexp(i + 1, -149)
+                                             : (float)ldexp(1.0 + i / (double)blockSize, b - 150);  break;
+            }
+            in[b * blockSize + i] = x;
+        }
+    }
+    return in;
+}
+
+//.................................................................................................................. maxError
+// absolute for sin, cos and log2 (relative where |result| > 1), relative for exp2 and sqrt over the normal range of
+// the result
+static double maxError(int function, const std::vector<float>& in, const std::vector<float>& out)
+{
+    double worst = 0;
+    for (size_t i = 0; i < in.size(); i++) {
+        double ref = reference(function, in[i]);
+        double err = fabs(out[i] - ref);
+        if (function == DSP_MATH_EXP2 || function == DSP_MATH_SQRT) {
+            err = (ref >= 1.17549435e-38 && ref < 3.4e38) ? err / ref : 0;
+        } else if (fabs(ref) > 1) {
+            err /= fabs(ref);
+        }
+        worst = (err > worst) ? err : worst;
+    }
+    return worst;
+}
+
+//.................................................................................................................. testSweeps
+static void testSweeps(void)
+{
+    int topLevel = dsp_setSimdLevel(DSP_SIMD_AVX512);
+
+    for (int f = 0; f < 5; f++) {
+        int function = DSP_MATH_SIN + f;
+        std::vector<float> in = arguments(function);
+        std::vector<float> out(in.size()), first(in.size());
+
+        for (int p = 0; p < 3; p++) {
+            dsp_setPrecision(DSP_PRECISION_EXACT + p);
+
+            for (int level = DSP_SIMD_SCALAR; level <= topLevel; level++) {
+                dsp_setSimdLevel(level);
+                evaluate(function, in.data(), (long long)in.size(), out.data());
+
+                double err = maxError(function, in, out);
+                printf("%-5s %-6s %-8s max error %.2e (bound %.1e)\n", functionNames[f], precisionNames[p],
+                       levelNames[level], err, bounds[f][p]);
+
+                char what[128];
+                snprintf(what, sizeof(what), "%s %s %s above its bound", functionNames[f], precisionNames[p], levelNames[level]);
+                check(err <= bounds[f][p], what);
+
+                if (level == DSP_SIMD_SCALAR) {
+                    first = out;
+                } else {
+                    snprintf(what, sizeof(what), "%s %s %s differs from scalar", functionNames[f], precisionNames[p], levelNames[level]);
+                    check(memcmp(first.data(), out.data(), out.size() * sizeof(float)) == 0, what);
+                }
+            }
+        }
+    }
+
+    dsp_setSimdLevel(topLevel);
+    dsp_setPrecision(DSP_PRECISION_EXACT);
+}
+
+//.................................................................................................................. testDomains
+static void testDomains(void)
+{
+    for (int p = 0; p < 3; p++) {
+        dsp_setPrecision(DSP_PRECISION_EXACT + p);
+
+        float in[4] = { -200.0f, 128.0f, 0.0f, 0.0f };
+        float out[4];
+        dsp_exp2Array(in, 2, out);
+        check(out[0] <= 1.5e-45f, "exp2 below -150 is not 0 or the smallest denormal");
+        check(isinf(out[1]) && out[1] > 0, "exp2(128) is not +inf");
+
+        in[0] = 0.0f;
+        in[1] = -1.0f;
+        in[2] = 1.0f;
+        in[3] = 1.0e-40f;
+        dsp_log2Array(in, 4, out);
+        check(isinf(out[0]) && out[0] < 0, "log2(0) is not -inf");
+        check(isnan(out[1]), "log2(-1) is not NaN");
+        check(out[2] == 0.0f, "log2(1) is not 0");
+        check(fabs(out[3] - log2(1.0e-40)) < 1e-5 * 133, "log2 of a denormal is wrong");
+    }
+
+    float x = 1.0f, y;
+    check(dsp_sinArray(NULL, 1, &y) == DSP_NULL_IN_POINTER, "null input accepted");
+    check(dsp_sinArray(&x, 1, NULL) == DSP_NULL_OUT_POINTER, "null output accepted");
+    check(dsp_sinArray(&x, 0, &y) == DSP_INVALID_PARAMETER, "empty array accepted");
+    check(dsp_setPrecision(99) == DSP_INVALID_PARAMETER, "unknown tier accepted");
+
+    dsp_setPrecision(DSP_PRECISION_EXACT);
+}
+
+//.................................................................................................................. main
+int main(void)
+{
+    testSweeps();
+    testDomains();
+
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, (failures == 1) ? "" : "s");
+    return failures ? 1 : 0;
+}